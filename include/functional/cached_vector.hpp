@@ -0,0 +1,4 @@
+#pragma once
+
+#include "cached_vector/cached_vector.hpp"
+#include "cached_vector/functor.hpp"
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <functional/common.hpp>
+
+#include <algorithm>
+#include <any>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+/**
+ * Tag for cached_vector::map(), promising the function behaves the same as the
+ *  last one of its type. Lets capturing lambdas reuse the cache.
+ **/
+struct assume_same_function_t { explicit assume_same_function_t() = default; };
+inline constexpr assume_same_function_t assume_same_function{};
+
+/**
+ * A std::vector wrapper that remembers the result of its last map().
+ *
+ * Writes go through set()/update()/push_back()/pop_back(), which record the
+ *  touched positions. Mapping again with the same function then only
+ *  recomputes those positions and reuses the cached output for the rest,
+ *  keeping the output's storage between calls.
+ *
+ * Functions are recognised by type. Stateless ones (captureless lambdas) and
+ *  equality comparable ones (function pointers) can reuse the cache on their
+ *  own. Other function objects, like capturing lambdas, recompute everything
+ *  unless map() is passed #assume_same_function, since two lambdas of the same
+ *  type may still capture different state. Mapping with a new function
+ *  replaces the cache.
+ *
+ * Copies only copy the elements; the cache stays with the original.
+ **/
+template<typename A>
+class cached_vector {
+	std::vector<A> elems;
+
+	// Positions written to since the last map(). The flags dedupe the list.
+	std::vector<bool> dirty_flags;
+	std::vector<std::size_t> dirty_list;
+	bool all_dirty = true;
+
+	// Smallest size reached since the last map(). Output past it is stale,
+	//  even if the elements were pushed back since.
+	std::size_t min_size = 0;
+
+	// Type of the last function, a copy of it if it can be compared, and
+	//  its std::vector output
+	const std::type_info *cached_fun_type = nullptr;
+	std::any cached_fun;
+	std::any cached_out;
+
+	void mark(std::size_t i)
+	{
+		if(all_dirty || dirty_flags[i]) return;
+		dirty_flags[i] = true;
+		dirty_list.push_back(i);
+	}
+
+	void clean()
+	{
+		for(auto i: dirty_list)
+			if(i < dirty_flags.size()) dirty_flags[i] = false;
+		dirty_list.clear();
+		all_dirty = false;
+		min_size = elems.size();
+	}
+
+	template<typename Function>
+	bool same_fun(const Function& fun, bool assume_same) const
+	{
+		if(cached_fun_type == nullptr || *cached_fun_type != typeid(Function))
+			return false;
+
+		if constexpr(std::is_empty_v<Function>) return true;
+		else if constexpr(std::equality_comparable<Function>)
+			return *std::any_cast<Function>(&cached_fun) == fun;
+		else return assume_same;
+	}
+
+	template<typename Function>
+	const std::vector<invoke_return_t<Function, A>>&
+	map_impl(Function&& fun, bool assume_same)
+	{
+		using fun_t = std::decay_t<Function>;
+		using out_t = std::vector<invoke_return_t<Function, A>>;
+
+		// Patching single elements needs assignment, growing and
+		//  shrinking only needs what std::vector does.
+		constexpr bool patchable =
+			std::is_move_assignable_v<typename out_t::value_type>;
+
+		auto *out = std::any_cast<out_t>(&cached_out);
+		bool full = all_dirty || out == nullptr
+			|| !same_fun<fun_t>(fun, assume_same)
+			|| (!patchable && !dirty_list.empty());
+
+		if(out == nullptr) out = &cached_out.emplace<out_t>();
+		if(full) {
+			// Stays set if fun throws, so a half-written output is
+			//  never reused.
+			all_dirty = true;
+			cached_fun_type = nullptr;
+			out->clear();
+		}
+		while(out->size() > min_size) out->pop_back();
+
+		if constexpr(patchable)
+			if(!full)
+				for(auto i: dirty_list)
+					if(i < out->size()) (*out)[i] = fun(elems[i]);
+
+		out->reserve(elems.size());
+		for(auto i = out->size(); i < elems.size(); i++)
+			out->push_back(fun(elems[i]));
+
+		if(full) {
+			if constexpr(std::equality_comparable<fun_t> && std::copy_constructible<fun_t>)
+				cached_fun.emplace<fun_t>(std::forward<Function>(fun));
+			else
+				cached_fun.reset();
+			cached_fun_type = &typeid(fun_t);
+		}
+		clean();
+
+		return *out;
+	}
+
+public:
+	cached_vector() = default;
+	cached_vector(std::vector<A> elems)
+		: elems(std::move(elems)), dirty_flags(this->elems.size()) {}
+	cached_vector(std::initializer_list<A> elems)
+		: cached_vector(std::vector<A>(elems)) {}
+
+	cached_vector(const cached_vector& other) : cached_vector(other.elems) {}
+	cached_vector(cached_vector&&) = default;
+
+	cached_vector& operator=(const cached_vector& other)
+	{
+		if(this != &other) *this = cached_vector(other);
+		return *this;
+	}
+	cached_vector& operator=(cached_vector&&) = default;
+
+	const std::vector<A>& items() const & { return elems; }
+	std::vector<A> items() && { return std::move(elems); }
+
+	std::size_t size() const { return elems.size(); }
+	const A& operator[](std::size_t i) const { return elems[i]; }
+	auto begin() const { return elems.begin(); }
+	auto end() const { return elems.end(); }
+
+	// Marking comes first, so a write that throws part-way still gets
+	//  recomputed.
+	void set(std::size_t i, A value)
+	{
+		mark(i);
+		elems[i] = std::move(value);
+	}
+
+	/** Modifies the element at i in place with fun(A&) **/
+	template<typename Function>
+	void update(std::size_t i, Function&& fun)
+	{
+		mark(i);
+		std::invoke(std::forward<Function>(fun), elems[i]);
+	}
+
+	// Growing doesn't need marking: map() extends the output to match.
+	void push_back(A value)
+	{
+		elems.push_back(std::move(value));
+		dirty_flags.push_back(false);
+	}
+
+	void pop_back()
+	{
+		elems.pop_back();
+		dirty_flags.pop_back();
+		min_size = std::min(min_size, elems.size());
+	}
+
+	/** Forces the next map() to recompute every element **/
+	void invalidate() { all_dirty = true; }
+
+	/**
+	 * Maps fun over the elements, recomputing only what changed since the
+	 *  last call with the same function.
+	 *
+	 * The returned reference points into the cache: it is only valid until
+	 *  the next map() call, which may rewrite or destroy it.
+	 **/
+	template<typename Function>
+	const std::vector<invoke_return_t<Function, A>>&
+	map(Function&& fun)
+	{ return map_impl(std::forward<Function>(fun), false); }
+
+	/**
+	 * Same as map(fun), but any function of the same type as the last one
+	 *  counts as the same function. The caller must invalidate() if its
+	 *  captured state changes.
+	 **/
+	template<typename Function>
+	const std::vector<invoke_return_t<Function, A>>&
+	map(assume_same_function_t, Function&& fun)
+	{ return map_impl(std::forward<Function>(fun), true); }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functor.hpp>
+
+#include "cached_vector.hpp"
+#include "../vector/functor.hpp"
+
+/**
+ * Only recomputes elements written to since the last fmap() with the same
+ *  function, then copies the cached output into a new cached_vector. Use
+ *  #cached_vector::map() to read the cache without copying.
+ **/
+template<typename A, typename Function>
+auto
+fmap(Function&& fun, cached_vector<A>& functor)
+{
+	return cached_vector<invoke_return_t<Function, A>>(functor.map(std::forward<Function>(fun)));
+}
+
+/**
+ * Const and temporary cached_vectors can't keep a cache, so they are mapped
+ *  like a plain std::vector.
+ **/
+template<typename A, typename Function>
+auto
+fmap(Function&& fun, const cached_vector<A>& functor)
+{
+	return cached_vector<invoke_return_t<Function, A>>(fmap(std::forward<Function>(fun), functor.items()));
+}
+
+template<typename A, typename Function>
+auto
+fmap(Function&& fun, cached_vector<A>&& functor)
+{
+	return cached_vector<invoke_return_t<Function, A>>(fmap(std::forward<Function>(fun), std::move(functor).items()));
+}
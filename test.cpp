@@ -2,6 +2,7 @@
 #include <functional/array.hpp>
 #include <functional/pair.hpp>
 #include <functional/string.hpp>
+#include <functional/cached_vector.hpp>
 
 #include <monoid.hpp>
 #include <extract.hpp>
@@ -44,10 +45,15 @@ auto mempty<MyInt> = MyInt(3);
 
 template<> constexpr auto mempty<int> = 0;
 
+static int square_calls = 0;
+int counted_square(int i) { square_calls++; return i * i; }
+
+#include <cassert>
 #include <iostream>
 int main()
 {
 	static_assert(is_functor<std::vector<int>>::value, "vector is_fmappable");
+	static_assert(is_functor_v<cached_vector<int>>, "cached_vector is_fmappable");
 
 	static_assert(
 		std::is_same<
@@ -91,6 +97,69 @@ int main()
 	for(auto a: char_vec) std::cout << a << " ";
 	std::cout << std::endl;
 
+	cached_vector<int> cached = { 1, 2, 3, 4, 5 };
+	fmap(counted_square, cached);
+	cached.set(1, 10);
+	cached.push_back(6);
+	square_calls = 0;
+	std::vector squares = fmap(counted_square, cached).items();
+	assert(square_calls == 2);
+	assert((squares == std::vector{ 1, 100, 9, 16, 25, 36 }));
+
+	std::cout << "cached_vector (" << square_calls << " recomputed): ";
+	for(auto a: squares) std::cout << a << " ";
+	std::cout << std::endl;
+
+	// Shrinking then growing back to the same size
+	cached.pop_back();
+	cached.pop_back();
+	cached.push_back(7);
+	cached.push_back(8);
+	square_calls = 0;
+	assert((fmap(counted_square, cached).items() == std::vector{ 1, 100, 9, 16, 49, 64 }));
+	assert(square_calls == 2);
+
+	// A throwing function must not leave its partial output in the cache
+	try { fmap([](int i){ if(i == 9) throw i; return -i; }, cached); }
+	catch(int) {}
+	assert((fmap(counted_square, cached).items() == std::vector{ 1, 100, 9, 16, 49, 64 }));
+
+	// Switching function, and result type
+	static_assert(std::is_same_v<decltype(fmap([](int i)->char{ return 'A' + i; }, cached)), cached_vector<char>>);
+	assert((fmap([](int i)->char{ return 'A' + i; }, cached)[0] == 'B'));
+	square_calls = 0;
+	assert((fmap(counted_square, cached).items() == std::vector{ 1, 100, 9, 16, 49, 64 }));
+	assert(square_calls == 6);
+
+	// An update() that throws after writing still gets recomputed
+	try { cached.update(0, [](int &x){ x = 5; throw x; }); }
+	catch(int) {}
+	assert(cached.map(counted_square)[0] == 25);
+
+	// Capturing lambdas only reuse the cache when asked to
+	int offset = 1;
+	auto add_offset = [offset](int i){ square_calls++; return i + offset; };
+	cached.map(assume_same_function, add_offset);
+	cached.set(1, 7);
+	square_calls = 0;
+	assert((cached.map(assume_same_function, add_offset) == std::vector{ 6, 8, 4, 5, 8, 9 }));
+	assert(square_calls == 1);
+	cached.set(1, 8);
+	square_calls = 0;
+	cached.map(add_offset);
+	assert(square_calls == 6);
+
+	// Results without assignment fall back to recomputing everything
+	struct unassignable { const int v; };
+	cached.set(2, 4);
+	assert(cached.map([](int i){ return unassignable{ i }; })[2].v == 4);
+	cached.set(2, 5);
+	assert(cached.map([](int i){ return unassignable{ i }; })[2].v == 5);
+
+	const cached_vector<int> const_cached = { 1, 2 };
+	assert((fmap(counted_square, const_cached).items() == std::vector{ 1, 4 }));
+	assert((fmap(counted_square, cached_vector<int>{ 3 }).items() == std::vector{ 9 }));
+
 	std::cout << "unwrap_second_t<std::array<int, 23>> = "
 		  << type_name<unwrap_second_t<std::array<int, 23>>>()
 		  << std::endl;